@@ -9,6 +9,79 @@
 #define DEVICETABLE_CPP_
 #include "DeviceTable.h"
 
+/* Returns whether every page in the range is resident or waiting to be written back,
+ * moving resident pages to the front of 'lru'.
+ */
+bool PageCache::lookup(const int PID, const int first, const int count)
+{
+	bool allResident = true;
+	for (int page = first; page < first + count; page++)
+	{
+		auto found = index.find(make_pair(PID, page));
+		if (found == index.end())
+		{
+			if (evicted.count(make_pair(PID, page)) == 0)
+				allResident = false;
+		}
+		else
+			lru.splice(lru.begin(), lru, found->second);
+	}
+	return allResident;
+}
+
+/* Makes every page in the range resident, marking them dirty if 'dirty' is set
+ * (or if the page was evicted while dirty). Evicts least recently used pages as
+ * needed. Evicted dirty pages are kept in 'evicted' until the next flush().
+ */
+void PageCache::insert(const int PID, const int first, const int count, bool dirty)
+{
+	for (int page = first; page < first + count; page++)
+	{
+		auto found = index.find(make_pair(PID, page));
+		if (found != index.end())
+		{
+			lru.splice(lru.begin(), lru, found->second);
+			if (dirty && !lru.front().dirty)
+			{
+				lru.front().dirty = true;
+				dirtyPages++;
+			}
+			continue;
+		}
+
+		//A page evicted while dirty comes back still dirty instead of being counted twice.
+		bool wasDirty = evicted.erase(make_pair(PID, page)) > 0;
+
+		if (lru.size() >= (size_t)capacity)
+		{
+			Page &victim = lru.back();
+			if (victim.dirty)
+			{
+				dirtyPages--;
+				evicted.insert(make_pair(victim.PID, victim.number));
+			}
+			index.erase(make_pair(victim.PID, victim.number));
+			lru.pop_back();
+		}
+
+		lru.push_front(Page(PID, page, dirty || wasDirty));
+		index[make_pair(PID, page)] = lru.begin();
+		if (dirty || wasDirty)
+			dirtyPages++;
+	}
+}
+
+// Marks every page clean and returns how many pages were waiting to be written back.
+int PageCache::flush()
+{
+	int flushed = unflushed();
+	for (Page &page : lru)
+		page.dirty = false;
+	dirtyPages = 0;
+	evicted.clear();
+	return flushed;
+}
+
 /* Process requests a core. If none is available, process is added
  * to the I or NI queue and set to the READY state. Otherwise, core
  * is occupied for time in 'howLong' and process is in RUNNING state.
@@ -80,23 +153,31 @@ string DeviceTable::coreRelease(ProcessTable &table, ProcessTable::Process &proc
 	return output;
 }
 
-/* Process requests the SSD. If it is not free, process is added to the SSD queue
- * and set to the READY state. Otherwise, SSD is occupied for time in 'howLong' and
- * process is in BLOCKED state.
+/* Process requests an SSD. If none is free, process is added to the SSD queue
+ * and set to the READY state. Otherwise, an SSD is occupied for time in 'howLong' and
+ * process is in BLOCKED state. For 'writebackProcess', 'howLong' is replaced by the
+ * time to write back every waiting page, which are marked clean once it gets an SSD.
  */
 string DeviceTable::ssdRequest(ProcessTable &table, ProcessTable::Process &process, int howLong)
 {
 	string output;
+	if (&process == writebackProcess)
+		howLong = cache.unflushed() * cache.writebackTime;
 	output += "Process " + to_string(process.PID) + " requests SSD access at time " + to_string(process.curTime) + " ms for " + to_string(howLong) + " ms.\n";
-	if (ssdState.compare("FREE") == 0)
+	if (freeSSDs > 0)
 	{
+		if (&process == writebackProcess)
+		{
+			writebackPages = cache.flush();
+			output += "Page cache writes back " + to_string(writebackPages) + " dirty page(s).\n";
+		}
 		process.curTime += howLong;
 		ssdTime += howLong;
 		ssdAccesses++;
-		output += "Process " + to_string(process.PID) + " will release the SSD at time " + to_string(process.curTime) + " ms.\n";
+		output += "Process " + to_string(process.PID) + " will release an SSD at time " + to_string(process.curTime) + " ms.\n";
 		process.state = "BLOCKED";
 		process.addAgain = true;
-		ssdState = "BUSY";
+		freeSSDs--;
 	}
 	else
 	{
@@ -109,14 +190,70 @@ string DeviceTable::ssdRequest(ProcessTable &table, ProcessTable::Process &proce
 	return output;
 }
 
-/* Process releases the SSD. If SSD queue is not empty, top process gets the SSD next.
- * Releasing process set to READY state.
+/* Process makes an SSD request through the page cache. A read that hits the cache,
+ * or a write that does not fill up the writeback batch (or finds a batch already
+ * waiting), completes immediately and leaves the process READY. A read miss becomes
+ * a regular ssdRequest(); a write that fills the batch becomes 'writebackProcess'.
+ */
+string DeviceTable::cacheRequest(ProcessTable &table, ProcessTable::Process &process, ProcessTable::Process::Event &event)
+{
+	if (!cache.enabled() || event.page < 0)
+		return ssdRequest(table, process, event.timeNeeded);
+
+	string output;
+	string range = "page(s) " + to_string(event.page) + "-" + to_string(event.page + event.pages - 1);
+	if (!event.isWrite)
+	{
+		if (cache.lookup(process.PID, event.page, event.pages))
+		{
+			cache.hits++;
+			output += "Process " + to_string(process.PID) + " finds " + range + " in the page cache at time " + to_string(process.curTime) + " ms.\n";
+			process.addAgain = true;
+			process.state = "READY";
+			return output;
+		}
+		cache.misses++;
+		output += "Process " + to_string(process.PID) + " misses " + range + " in the page cache at time " + to_string(process.curTime) + " ms.\n";
+		return output + ssdRequest(table, process, event.timeNeeded);
+	}
+
+	cache.insert(process.PID, event.page, event.pages, true);
+	output += "Process " + to_string(process.PID) + " writes " + range + " to the page cache at time " + to_string(process.curTime) + " ms.\n";
+	//A batch that is still waiting for an SSD will pick up these pages too.
+	if (!cache.needsWriteback() || writebackProcess != nullptr)
+	{
+		process.addAgain = true;
+		process.state = "READY";
+		return output;
+	}
+
+	writebackProcess = &process;
+	return output + ssdRequest(table, process, event.timeNeeded);
+}
+
+/* Process releases its SSD. If SSD queue is not empty, top process gets that SSD next.
+ * Pages read by the releasing process are added to the page cache; any dirty pages
+ * this evicts are written back with the next batch. A finished batched writeback is
+ * counted here. Releasing process set to READY state.
  */
 string DeviceTable::ssdRelease(ProcessTable &table, ProcessTable::Process &process)
 {
 	string output;
 	output += "SSD completion event for process " + to_string(process.PID) + " at time " + to_string(process.curTime) + " ms.\n";
-	ssdState = "FREE";
+	freeSSDs++;
+	if (&process == writebackProcess)
+	{
+		cache.pagesWrittenBack += writebackPages;
+		cache.writebacks++;
+		writebackProcess = nullptr;
+		writebackPages = 0;
+	}
+	ProcessTable::Process::Event &done = process.events.at(process.PC-1);
+	if (cache.enabled() && done.page >= 0 && !done.isWrite)
+	{
+		//Dirty pages evicted here are written back with the next batch.
+		cache.insert(process.PID, done.page, done.pages, false);
+	}
 	ProcessTable::Process* proc;
 	if (!ssd.empty())
 	{
@@ -226,7 +363,7 @@ string DeviceTable::nextEvent(ProcessTable &p)
 	}
 	else if (event.eventType.compare("SSD") == 0)
 	{
-		output += ssdRequest(p, *process, event.timeNeeded);
+		output += cacheRequest(p, *process, process->events.at(process->PC));
 	}
 	else if (event.eventType.compare("TTY") == 0)
 	{
@@ -253,12 +390,34 @@ string DeviceTable::nextEvent(ProcessTable &p)
 string DeviceTable::finalStats(ProcessTable &p)
 {
 	string output;
+
+	/* Flush whatever is still dirty at shutdown on one SSD, after the last process terminates.
+	 * This costs the same 'writebackTime' per page as a batched writeback but is reported on its own.
+	 */
+	int shutdownPages = 0;
+	if (cache.enabled() && cache.unflushed() > 0)
+	{
+		shutdownPages = cache.flush();
+		int flushTime = shutdownPages * cache.writebackTime;
+		ssdTime += flushTime;
+		ssdAccesses++;
+		elapsedTime += flushTime;
+	}
+
 	output += "================SUMMARY================\n";
 	output += "Total elapsed time: " + to_string(elapsedTime) + " ms\n";
 	output += "Number of completed processes: " + to_string(p.processes.size()) + "\n";
 	output += "Total number of SSD accesses: " + to_string(ssdAccesses) + "\n";
 	output += "Average number of busy cores: " + to_string((float)coreTime/elapsedTime)+ "\n";
-	output += "SSD utilization: " + to_string((float)ssdTime/elapsedTime);
+	output += "SSD utilization: " + to_string((float)ssdTime/(elapsedTime*numSSDs));
+	if (cache.enabled())
+	{
+		int reads = cache.hits + cache.misses;
+		output += "\nPage cache reads: " + to_string(reads) + " (" + to_string(cache.hits) + " hits, " + to_string(cache.misses) + " misses)\n";
+		output += "Page cache hit rate: " + to_string(reads == 0 ? 0.0f : (float)cache.hits/reads) + "\n";
+		output += "Dirty pages written back during the run: " + to_string(cache.pagesWrittenBack) + " in " + to_string(cache.writebacks) + " batched writeback(s)\n";
+		output += "Dirty pages flushed at shutdown: " + to_string(shutdownPages);
+	}
 
 	return output;
 }
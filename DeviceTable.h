@@ -3,7 +3,9 @@
  * Benjamin Berryman
  *
  * The Device Table holds the I, NI, and SSD queues, as well as
- * all the request and release functions for the core(s) and SSD.
+ * all the request and release functions for the core(s) and SSD(s).
+ * When RAM is given in the input, SSD requests with a page range
+ * go through an LRU page cache (PageCache) first.
  * It also holds the function nextEvent(), which is the main driver
  * for the simulation, and finalStats(), which gives info about the
  * simulation once it has been completed.
@@ -11,21 +13,92 @@
 
 #ifndef DEVICETABLE_H_
 #define DEVICETABLE_H_
+#include <algorithm>
+#include <list>
+#include <map>
+#include <set>
 #include "ProcessTable.h"
 
+/* LRU page cache sitting in front of the SSD(s). Pages are keyed by
+ * (PID, page number), so each process has its own address space.
+ * Reads that find every page of their range resident never touch an SSD.
+ * Writes only dirty pages in the cache; once 'writebackBatch' pages are
+ * waiting to be written (dirty, or dirty and already evicted), they are
+ * all flushed together in a single SSD access costing 'writebackTime' ms per page.
+ * Evicted dirty pages still hold the newest data, so reads are served from them
+ * and writing one again merges with it instead of counting it twice.
+ */
+class PageCache
+{
+	friend class DeviceTable;
+	struct Page
+	{
+		Page(const int pid, const int num, bool d) : PID(pid), number(num), dirty(d){};
+		int PID;
+		int number;
+		bool dirty;
+	};
+
+	int capacity; //Size of the cache in pages (0 means the cache is disabled)
+	int writebackBatch; //Number of dirty pages that triggers a writeback
+	int writebackTime; //SSD time (ms) to write back one page
+	int dirtyPages; //Number of dirty pages currently in the cache
+	list<Page> lru; //Most recently used page at the front
+	map<pair<int, int>, list<Page>::iterator> index; //(PID, page number) -> position in 'lru'
+	set<pair<int, int>> evicted; //(PID, page number) of dirty pages evicted but not yet written back
+
+	int hits; //Reads fully served by the cache
+	int misses; //Reads that had to go to an SSD
+	int pagesWrittenBack; //Dirty pages written to the SSD(s) by completed batched writebacks
+	int writebacks; //Number of completed batched writebacks
+
+	//A batch larger than the cache could never fill up, so it is clamped to 'ram'.
+	PageCache(const int ram, const int batch, const int pageTime) : capacity(ram),
+												writebackBatch(batch > 0 ? min(batch, max(1, ram)) : max(1, ram/4)),
+												writebackTime(pageTime), dirtyPages(0),
+												hits(0), misses(0), pagesWrittenBack(0), writebacks(0){};
+
+	// Returns whether the cache is in use.
+	bool enabled() {return capacity > 0;}
+
+	/* Returns whether every page in the range is resident or waiting to be written back,
+	 * moving resident pages to the front of 'lru'.
+	 */
+	bool lookup(const int PID, const int first, const int count);
+
+	/* Makes every page in the range resident, marking them dirty if 'dirty' is set
+	 * (or if the page was evicted while dirty). Evicts least recently used pages as
+	 * needed. Evicted dirty pages are kept in 'evicted' until the next flush().
+	 */
+	void insert(const int PID, const int first, const int count, bool dirty);
+
+	// Returns the number of pages waiting to be written back.
+	int unflushed() {return dirtyPages + evicted.size();}
+
+	// Returns whether enough pages are waiting to be written back to need a writeback.
+	bool needsWriteback() {return unflushed() >= writebackBatch;}
+
+	// Marks every page clean and returns how many pages were waiting to be written back.
+	int flush();
+};
+
 class DeviceTable
 {
 	int numCores;
 	int freeCores;
-	string ssdState; // FREE or BUSY
+	int numSSDs;
+	int freeSSDs;
+	PageCache cache;
+	ProcessTable::Process *writebackProcess; //Process carrying the current batched writeback, or nullptr
+	int writebackPages; //Pages being written back by 'writebackProcess' once it has an SSD
 	queue<ProcessTable::Process*> interactive; //I Queue
 	queue<ProcessTable::Process*> noninteractive; //NI Queue
 	queue<ProcessTable::Process*> ssd; //SSD Queue
 
 	int elapsedTime; //Only updated at TERMINATION events
-	int ssdAccesses; //Number of times the SSD was accessed.
+	int ssdAccesses; //Number of times the SSD(s) was/were accessed.
 	int coreTime; //Total amount of time core(s) was/were used.
-	int ssdTime; //Total amount of time SSD was used.
+	int ssdTime; //Total amount of time SSD(s) was/were used.
 
 	/* Process requests a core. If none is available, process is added
 	 * to the I or NI queue and set to the READY state. Otherwise, core
@@ -39,14 +112,24 @@ class DeviceTable
 	 */
 	string coreRelease(ProcessTable &table, ProcessTable::Process &process);
 
-	/* Process requests the SSD. If it is not free, process is added to the SSD queue
-	 * and set to the READY state. Otherwise, SSD is occupied for time in 'howLong' and
-	 * process is in BLOCKED state.
+	/* Process requests an SSD. If none is free, process is added to the SSD queue
+	 * and set to the READY state. Otherwise, an SSD is occupied for time in 'howLong' and
+	 * process is in BLOCKED state. For 'writebackProcess', 'howLong' is replaced by the
+	 * time to write back every waiting page, which are marked clean once it gets an SSD.
 	 */
 	string ssdRequest(ProcessTable &table, ProcessTable::Process &process, int howLong);
 
-	/* Process releases the SSD. If SSD queue is not empty, top process gets the SSD next.
-	 * Releasing process set to READY state.
+	/* Process makes an SSD request through the page cache. A read that hits the cache,
+	 * or a write that does not fill up the writeback batch (or finds a batch already
+	 * waiting), completes immediately and leaves the process READY. A read miss becomes
+	 * a regular ssdRequest(); a write that fills the batch becomes 'writebackProcess'.
+	 */
+	string cacheRequest(ProcessTable &table, ProcessTable::Process &process, ProcessTable::Process::Event &event);
+
+	/* Process releases its SSD. If SSD queue is not empty, top process gets that SSD next.
+	 * Pages read by the releasing process are added to the page cache; any dirty pages
+	 * this evicts are written back with the next batch. A finished batched writeback is
+	 * counted here. Releasing process set to READY state.
 	 */
 	string ssdRelease(ProcessTable &table, ProcessTable::Process &process);
 
@@ -58,13 +141,18 @@ class DeviceTable
 
 public:
 	DeviceTable(ProcessTable &p) : numCores(p.getCores()), freeCores(p.getCores()),
-									ssdState("FREE"),elapsedTime(0), ssdAccesses(0),
+									numSSDs(p.getSSDs()), freeSSDs(p.getSSDs()),
+									cache(p.getRamPages(), p.getWritebackPages(), p.getWritebackTime()),
+									writebackProcess(nullptr), writebackPages(0),
+									elapsedTime(0), ssdAccesses(0),
 									coreTime(0), ssdTime(0){};
 
 	//MAIN DRIVER FUNCTION: takes top process from the given ProcessTable's 'eventList' and processes it.
 	string nextEvent(ProcessTable &p);
 
-	//Once simulation has ended, prints out info about it.
+	/* Once simulation has ended, prints out info about it. Pages still waiting
+	 * to be written back are flushed first, adding that SSD time to the run.
+	 */
 	string finalStats(ProcessTable &p);
 };
 
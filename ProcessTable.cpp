@@ -13,6 +13,7 @@
  * 	to SMALLEST curTime) for use in the DeviceTable's nextEvent() function.
  */
 
+#include <stdexcept>
 #include "ProcessTable.h"
 
 /* Translates each of the lines from the given InputTable into processes,
@@ -25,6 +26,8 @@ void ProcessTable::transfer(InputTable &t)
 	InputTable::Entry *temp;
 	string op;
 	int time;
+	int page;
+	int pages;
 
 	/* ===============================================================================
 	 * FIRST, transfer contents of InputTable to ProcessTable
@@ -42,11 +45,37 @@ void ProcessTable::transfer(InputTable &t)
 		temp = &t.lines.front();
 		op = temp->operation;
 		time = temp->time;
+		page = temp->page;
+		pages = temp->pages;
 
 		if (op.compare("NCORES") == 0)
 		{
 			cores = time;
 		}
+		else if (op.compare("NSSDS") == 0)
+		{
+			if (time < 1)
+				throw std::invalid_argument("NSSDS must be at least 1");
+			ssds = time;
+		}
+		else if (op.compare("RAM") == 0)
+		{
+			if (time < 0)
+				throw std::invalid_argument("RAM must not be negative");
+			ramPages = time;
+		}
+		else if (op.compare("WRITEBACK") == 0)
+		{
+			if (time < 0)
+				throw std::invalid_argument("WRITEBACK must not be negative");
+			writebackPages = time;
+		}
+		else if (op.compare("WRITEBACKTIME") == 0)
+		{
+			if (time < 0)
+				throw std::invalid_argument("WRITEBACKTIME must not be negative");
+			writebackTime = time;
+		}
 		else if (op.compare("START") == 0)
 		{
 			if (newProcess)
@@ -71,7 +100,11 @@ void ProcessTable::transfer(InputTable &t)
 		}
 		else if (op.compare("SSD") == 0 )
 		{
-			current->events.push_back(*new Process::Event("SSD", time));
+			current->events.push_back(*new Process::Event("SSD", time, page, pages));
+		}
+		else if (op.compare("SSDW") == 0)
+		{
+			current->events.push_back(*new Process::Event("SSD", time, page, pages, true));
 		}
 		else if (op.compare("TTY") == 0)
 		{
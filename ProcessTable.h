@@ -26,15 +26,17 @@ class InputTable
 	{
 		const string operation;
 		const int time;
+		const int page; //First page of an SSD/SSDW request, or -1 if none was given
+		const int pages; //Number of pages in an SSD/SSDW request
 
-		Entry(const string &op, const int &t) : operation(op), time(t){};
+		Entry(const string &op, const int &t, const int &pg, const int &n) : operation(op), time(t), page(pg), pages(n){};
 	};
 	queue<Entry> lines;
 
 public:
-	void add (const string op, const int time)
+	void add (const string op, const int time, const int page = -1, const int pages = 1)
 	{
-		lines.push(Entry(op, time));
+		lines.push(Entry(op, time, page, pages));
 	}
 
 };
@@ -46,10 +48,14 @@ class ProcessTable
 	{
 		struct Event
 		{
-			Event(string type, const int time) : eventType(type), timeNeeded(time), isInteractive(false){};
+			Event(string type, const int time, const int pg = -1, const int n = 1, bool write = false) :
+				eventType(type), timeNeeded(time), isInteractive(false), page(pg), pages(n), isWrite(write){};
 			string eventType;
 			int timeNeeded;
 			bool isInteractive;
+			int page; //First page of the SSD address range, or -1 to bypass the page cache
+			int pages; //Number of pages in the SSD address range
+			bool isWrite; //Whether an SSD event writes (SSDW) rather than reads (SSD)
 		};
 
 		Process(const int &time) : PID(-1), curTime(time), PC(0),
@@ -78,14 +84,24 @@ class ProcessTable
 	priority_queue<Process*, vector<Process*>, curTimeComp > eventList;
 
 	int cores; //Intermediate variable for assigning numCores variable in DeviceTable
+	int ssds; //Intermediate variable for assigning numSSDs variable in DeviceTable
+	int ramPages; //Size of the page cache in pages (0 disables the page cache)
+	int writebackPages; //Number of dirty pages that triggers a writeback (0 picks a default)
+	int writebackTime; //SSD time (ms) to write back one dirty page
 
 	/* Returns the number of cores.
 	 * NOTE: This is a private function because 'cores' is only used as an intermediate
 	 * variable to get to 'numCores' in DeviceTable (used in its constructor).
+	 * The same goes for the SSD and page cache getters below.
 	 */
 	int getCores() {return cores;}
+	int getSSDs() {return ssds;}
+	int getRamPages() {return ramPages;}
+	int getWritebackPages() {return writebackPages;}
+	int getWritebackTime() {return writebackTime;}
 
 public:
+	ProcessTable() : cores(1), ssds(1), ramPages(0), writebackPages(0), writebackTime(1){};
 
 	/* Translates each of the lines from the given InputTable into processes,
 	 * then make an Event List out of those processes.
@@ -10,10 +10,21 @@
 
 #include <iostream>
 #include <fstream>
-#include <algorithm>
+#include <sstream>
+#include <climits>
 #include "ProcessTable.h"
 #include "DeviceTable.h"
 
+//Converts one field of 'line' to an int, throwing invalid_argument unless the whole field is a number.
+int toInt(const std::string &field, const std::string &line)
+{
+	size_t pos = 0;
+	int value = stoi(field, &pos); //Throws invalid_argument if the field is missing or does not start with a number
+	if (pos != field.size())
+		throw std::invalid_argument("Invalid number '" + field + "': " + line);
+	return value;
+}
+
 int main(int argc, char *argv[])
 {
 	/* 	===========================================================================================
@@ -35,10 +46,25 @@ int main(int argc, char *argv[])
 		while (str != "END")
 		{
 			std::string op = str.substr(0,str.find(" "));
-			std::string temp = str.substr(str.find(" "));
-			temp.erase(remove_if(temp.begin(), temp.end(),::isspace), temp.end());
-			int num = stoi(temp);
-			input.add(op, num); //Adding every line to InputTable, with op as the string key, and num as the int value
+			std::istringstream fields(str.substr(str.find(" ")));
+			std::string field;
+			fields >> field;
+			int num = toInt(field, str);
+			int page = -1, pages = 1;
+			if (op.compare("SSD") == 0 || op.compare("SSDW") == 0) //SSD and SSDW lines may give an optional page range after the time
+			{
+				if (fields >> field)
+				{
+					page = toInt(field, str);
+					if (fields >> field)
+						pages = toInt(field, str);
+				}
+				if (page < -1 || pages < 1 || (page >= 0 && pages > INT_MAX - page)) //The range must not overflow an int
+					throw std::invalid_argument("Invalid page range: " + str);
+			}
+			if (fields >> field)
+				throw std::invalid_argument("Too many fields: " + str);
+			input.add(op, num, page, pages); //Adding every line to InputTable, with op as the string key, and num as the int value
 			getline(inFile,str);
 		}
 		inFile.close();